@@ -1,12 +1,23 @@
 #include <GL/glut.h>
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <ctime>
 #include <chrono>
-#include <string>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
+#include <mutex>
+#include <new>
+#include <thread>
 #include <vector>
 
+#include "dxball_env.h"
+
 #ifdef _WIN32
   #include <windows.h>
 #endif
@@ -14,6 +25,104 @@
 using namespace std;
 using Clock = chrono::steady_clock;
 
+// --- Allocation tracking (every form of global new/delete is replaced: plain, array, nothrow, aligned) ---
+// On by default for the game; the env library (-DDXBALL_NO_MAIN) must not replace its host's
+// allocator, so it leaves tracking out unless DXBALL_TRACK_ALLOCS is given explicitly.
+#if !defined(DXBALL_NO_MAIN) && !defined(DXBALL_TRACK_ALLOCS)
+  #define DXBALL_TRACK_ALLOCS
+#endif
+size_t allocsLastTick = 0, allocsLastFrame = 0;
+
+#ifdef DXBALL_TRACK_ALLOCS
+atomic<size_t> allocCount(0);
+
+// GCC's -Wmismatched-new-delete misfires on replaced operators that wrap malloc/free
+#if defined(__GNUC__) && !defined(__clang__)
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void *operator new(size_t n) {
+    allocCount.fetch_add(1, memory_order_relaxed);
+    if (void *p = malloc(n ? n : 1)) return p;
+    throw bad_alloc();
+}
+void *operator new[](size_t n) { return operator new(n); }
+void *operator new(size_t n, const nothrow_t &) noexcept {
+    allocCount.fetch_add(1, memory_order_relaxed);
+    return malloc(n ? n : 1);
+}
+void *operator new[](size_t n, const nothrow_t &t) noexcept { return operator new(n, t); }
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+void operator delete(void *p, const nothrow_t &) noexcept { free(p); }
+void operator delete[](void *p, const nothrow_t &) noexcept { free(p); }
+
+#ifdef __cpp_aligned_new
+// over-aligned types (alignas > 16); _WIN32 needs its own aligned heap
+void *alignedAllocCounted(size_t n, align_val_t al) noexcept {
+    allocCount.fetch_add(1, memory_order_relaxed);
+    size_t a = (size_t)al;
+    n = n ? (n + a - 1) / a * a : a; // aligned_alloc wants a multiple of the alignment
+#ifdef _WIN32
+    return _aligned_malloc(n, a);
+#else
+    return aligned_alloc(a, n);
+#endif
+}
+void alignedFree(void *p) noexcept {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+void *operator new(size_t n, align_val_t al) {
+    if (void *p = alignedAllocCounted(n, al)) return p;
+    throw bad_alloc();
+}
+void *operator new[](size_t n, align_val_t al) { return operator new(n, al); }
+void *operator new(size_t n, align_val_t al, const nothrow_t &) noexcept { return alignedAllocCounted(n, al); }
+void *operator new[](size_t n, align_val_t al, const nothrow_t &) noexcept { return alignedAllocCounted(n, al); }
+void operator delete(void *p, align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void *p, align_val_t) noexcept { alignedFree(p); }
+void operator delete(void *p, size_t, align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void *p, size_t, align_val_t) noexcept { alignedFree(p); }
+void operator delete(void *p, align_val_t, const nothrow_t &) noexcept { alignedFree(p); }
+void operator delete[](void *p, align_val_t, const nothrow_t &) noexcept { alignedFree(p); }
+#endif
+#if defined(__GNUC__) && !defined(__clang__)
+  #pragma GCC diagnostic pop
+#endif
+#endif // DXBALL_TRACK_ALLOCS
+
+// --- Per-frame arena (transient strings/scratch, reset at the end of display()) ---
+const size_t FRAME_ARENA_BYTES = 16 * 1024;
+alignas(16) char frameArena[FRAME_ARENA_BYTES];
+size_t frameArenaUsed = 0;
+
+void *frameAlloc(size_t n) {
+    size_t start = (frameArenaUsed + 15) & ~(size_t)15;
+    if (start + n > FRAME_ARENA_BYTES) return nullptr;
+    frameArenaUsed = start + n;
+    return frameArena + start;
+}
+void frameArenaReset() { frameArenaUsed = 0; }
+
+// printf into the frame arena; the result is valid until the arena is reset
+const char *frameFmt(const char *fmt, ...) {
+    va_list ap, ap2;
+    va_start(ap, fmt);
+    va_copy(ap2, ap);
+    int n = vsnprintf(nullptr, 0, fmt, ap);
+    va_end(ap);
+    char *dst = n < 0 ? nullptr : (char*)frameAlloc((size_t)n + 1);
+    if (dst) vsnprintf(dst, (size_t)n + 1, fmt, ap2);
+    va_end(ap2);
+    return dst ? dst : "";
+}
+
 // --- Window (actual) ---
 int windowWidth = 800;
 int windowHeight = 600;
@@ -26,6 +135,10 @@ Brick bricks[BR_ROWS * BR_COLS];
 int bricks_alive = 0;
 
 // --- Ball struct to support multiball ---
+// Containers below are reserved to these caps at startup so gameplay never reallocates.
+const int MAX_BALLS = 16384;
+const int MAX_PICKUPS = 256;
+const int MAX_LASERS = 64;
 struct Ball { float x,y,r; float sx,sy; bool stuck; bool mega; bool gravitySlow; };
 vector<Ball> balls;
 
@@ -33,7 +146,7 @@ vector<Ball> balls;
 enum PickupType { P_NONE=0, P_EXTRA_LIFE, P_SCORE_BONUS, P_ENLARGE_PADDLE, P_SLOW_MOTION, P_FAST_MOTION,
                   P_MULTIBALL, P_LASER, P_GRAB_PADDLE, P_MEGA_BALL, P_ZAP_BRICK,
                   P_SHRINK_PADDLE, P_FAST_BALL, P_GRAVITY_BALL };
-struct Pickup { PickupType type; float x,y; float vy; bool active; string emoji; };
+struct Pickup { PickupType type; float x,y; float vy; bool active; const char *emoji; };
 vector<Pickup> pickups;
 
 // --- Paddle & ball (values recomputed from window size) ---
@@ -47,8 +160,8 @@ enum GameState { STATE_MENU, STATE_PLAYING, STATE_HIGHSCORE };
 GameState state = STATE_MENU;
 
 // --- Menu text ---
-const int MENU_ITEMS = 4;
-string menuText[MENU_ITEMS] = { "Start", "Resume", "High Score", "Exit" };
+const int MENU_ITEMS = 5;
+const char *menuText[MENU_ITEMS] = { "Start", "Endless", "Resume", "High Score", "Exit" };
 
 // --- Power-up handling (eggs) ---
 bool eggActive = false;
@@ -69,12 +182,104 @@ bool laserEnabled = false;
 // --- Grab ---
 bool grabActive = false; // when true, next paddle collision will stick ball
 
+// --- Ball-ball collisions (optional, toggle with 'B') ---
+bool ballCollisions = false;
+vector<int> sapOrder; // ball indices sorted by left edge; kept between ticks so re-sorting is cheap
+vector<char> sapSeen;  // scratch for syncSapOrder
+
+// --- Endless mode: the brick field scrolls down; chunks of rows are streamed in above the screen ---
+// A fixed pool of chunk slots bounds memory: a background thread fills FREE slots ahead of the
+// camera, the game thread activates them in order and frees them once they scroll off the bottom.
+const int CHUNK_ROWS = 6;
+const int CHUNK_POOL = 8;
+enum ChunkStatus { CHUNK_FREE, CHUNK_LOADING, CHUNK_READY, CHUNK_ACTIVE };
+struct EndlessChunk {
+    ChunkStatus status; int index; int alive;
+    float y, h;                        // screen-space top and height
+    float x0, colPitch, rowPitch;      // layout captured when generated
+    Brick bricks[CHUNK_ROWS * BR_COLS]; // x absolute, y relative to chunk top
+};
+EndlessChunk chunkPool[CHUNK_POOL];
+int activeChunks[CHUNK_POOL];   // pool slots in play, bottom to top (game thread only)
+int activeChunkCount = 0;
+bool endlessMode = false;
+int endlessDepth = 0;           // chunks that have scrolled past
+float endlessScrollSpeed = 0.0f;
+struct ChunkLayout { float x0, colPitch, rowPitch, brickW, brickH; };
+ChunkLayout chunkLayout;
+unsigned int endlessSeed = 1;
+int nextChunkToGenerate = 0, nextChunkToActivate = 0;
+mutex chunkMutex;
+condition_variable chunkCv;
+thread chunkWorker;
+bool chunkWorkerStop = false;
+void stopEndlessStreaming();
+
+// --- Headless mode (no window, no sound, simulated clock; used by --alloc-check and the env API) ---
+bool headless = false;
+Clock::time_point simNow;  // advanced one tick per stepGame() when headless
+Clock::time_point gameNow() { return headless ? simNow : Clock::now(); }
+
+// --- RNG (small LCG so each game instance can carry its own seeded state) ---
+unsigned int rngState = 1;
+int gameRand() { rngState = rngState * 1103515245u + 12345u; return (int)((rngState >> 16) & 0x7fff); }
+
+// --- Quality governor (adapts render cost to the frame-time budget) ---
+// Level 3 is full quality; each step down trades visuals for a steadier frame rate.
+// Gameplay objects (balls, pickups) are always drawn, only more cheaply; just decorative passes are dropped.
+struct QualitySettings { int circleSeg; bool pickupLabels; bool brickBorders; const char *name; };
+const int QUALITY_LEVELS = 4;
+const QualitySettings qualityTable[QUALITY_LEVELS] = {
+    {  6, false, false, "LOW"    },
+    { 12, false, false, "MEDIUM" },
+    { 20, true,  true,  "HIGH"   },
+    { 36, true,  true,  "ULTRA"  }
+};
+int qualityLevel = QUALITY_LEVELS - 1;
+const float FRAME_BUDGET_MS = 16.0f;
+float frameWorkMs = 0.0f;     // smoothed CPU render cost per frame
+float frameIntervalMs = 0.0f; // smoothed time between frames minus the tick; catches GPU/fill-rate stalls
+float lastUpdateMs = 0.0f;    // cost of the most recent update() tick, kept out of the governor
+Clock::time_point lastFrameStart;
+int framesOverBudget = 0, framesUnderBudget = 0;
+const int STEP_UP_DELAY_BASE = 180;
+const int STEP_UP_HOLD_FRAMES = 600;   // a step up that lasts this long counts as having held
+int stepUpDelay = STEP_UP_DELAY_BASE;  // calm frames needed before stepping up; doubles if a step up does not hold
+int framesSinceStepUp = 1 << 30;
+bool showDebug = false;
+
+const QualitySettings &quality() { return qualityTable[qualityLevel]; }
+
+// Called once per frame with the CPU render time and the frame interval, both without the
+// simulation tick: a simulation-bound frame would not get faster by drawing less.
+// Steps down quickly when either runs hot, and only steps back up after a long stretch of low
+// render work. GPU-bound machines only show up in the interval, so a step up that runs straight
+// back into a slow interval doubles the wait before the next try; once one holds, the wait resets.
+void governQuality(float workMs, float intervalMs) {
+    frameWorkMs = frameWorkMs * 0.9f + workMs * 0.1f;
+    // the 16 ms timer alone makes a healthy interval ~16 ms
+    frameIntervalMs = frameIntervalMs * 0.9f + min(intervalMs, FRAME_BUDGET_MS * 4.0f) * 0.1f;
+    if (++framesSinceStepUp == STEP_UP_HOLD_FRAMES) stepUpDelay = STEP_UP_DELAY_BASE;
+    bool over = frameWorkMs > FRAME_BUDGET_MS * 0.75f || frameIntervalMs > FRAME_BUDGET_MS * 1.5f;
+    if (over) { framesOverBudget++; framesUnderBudget = 0; }
+    else if (frameWorkMs < FRAME_BUDGET_MS * 0.35f) { framesUnderBudget++; framesOverBudget = 0; }
+    else { framesOverBudget = 0; framesUnderBudget = 0; }
+
+    if (framesOverBudget >= 15 && qualityLevel > 0) {
+        qualityLevel--; framesOverBudget = 0;
+        if (framesSinceStepUp < STEP_UP_HOLD_FRAMES) stepUpDelay = min(stepUpDelay * 2, 60 * 60);
+    } else if (framesUnderBudget >= stepUpDelay && qualityLevel < QUALITY_LEVELS - 1) {
+        qualityLevel++; framesUnderBudget = 0; framesSinceStepUp = 0;
+    }
+}
+
 // --- Helpers ---
 float clampf(float v, float a, float b) { return (v < a ? a : (v > b ? b : v)); }
 bool resumeAvailable() { return gameStarted && state == STATE_MENU; }
 
 // play a short pip sound cross-platform
 void playPip() {
+    if (headless) return;
 #ifdef _WIN32
     Beep(880, 60);
 #else
@@ -83,7 +288,7 @@ void playPip() {
 }
 
 // map pickup type -> emoji string (visible in HUD and pickup label)
-string emojiFor(PickupType t) {
+const char *emojiFor(PickupType t) {
     switch(t) {
         case P_EXTRA_LIFE: return "❤️"; // extra life
         case P_SCORE_BONUS: return "⭐"; // score
@@ -106,7 +311,7 @@ string emojiFor(PickupType t) {
 // so modern terminals/GLUT implementations that support UTF-8 + fonts may show them, but on many systems
 // they will appear as empty boxes. Fallback: we draw a small colored circle and an ASCII short label.
 
-string shortLabelFor(PickupType t) {
+const char *shortLabelFor(PickupType t) {
     switch(t) {
         case P_EXTRA_LIFE: return "+1";
         case P_SCORE_BONUS: return "+100";
@@ -174,7 +379,7 @@ void setAllBricksAlive(bool alive) {
 void setRandomGoldenBricks(int numGolden) {
     int tries = 0;
     while (numGolden > 0 && tries < 1000) {
-        int idx = rand() % (BR_ROWS * BR_COLS);
+        int idx = gameRand() % (BR_ROWS * BR_COLS);
         if (bricks[idx].alive && !bricks[idx].golden) {
             bricks[idx].golden = true;
             numGolden--;
@@ -232,7 +437,7 @@ void spawnBall(float x, float y, float dirSign=1.0f) {
     b.stuck = true;
     b.mega = false;
     b.gravitySlow = false;
-    balls.push_back(b);
+    if ((int)balls.size() < MAX_BALLS) balls.push_back(b);
 }
 
 void resetBallsToPaddle() {
@@ -241,6 +446,8 @@ void resetBallsToPaddle() {
 }
 
 void startNewGame() {
+    if (endlessMode) stopEndlessStreaming();
+    endlessMode = false;
     gameStarted = true;
     score = 0; lives = 3;
     currentLevel = 1;
@@ -265,12 +472,13 @@ void nextLevel() {
 // --- Spawn pickup when brick breaks ---
 void spawnPickupAt(float x, float y) {
     // chance to spawn: ~45%
-    if ((rand()%100) > 45) return;
+    if ((gameRand()%100) > 45) return;
+    if ((int)pickups.size() >= MAX_PICKUPS) return;
     Pickup p;
-    int choice = rand() % 13; // choose among types
+    int choice = gameRand() % 13; // choose among types
     p.type = (PickupType)(1 + choice);
     p.x = x; p.y = y;
-    p.vy = windowHeight * 0.0075f + (rand()%5)/100.0f * windowHeight * 0.01f; // fall speed base
+    p.vy = windowHeight * 0.0075f + (gameRand()%5)/100.0f * windowHeight * 0.01f; // fall speed base
     p.active = true;
     p.emoji = emojiFor(p.type);
     pickups.push_back(p);
@@ -281,16 +489,16 @@ void applyPickupEffect(PickupType t) {
     // map to existing triggerEgg logic but immediate
     playPip();
     switch (t) {
-        case P_EXTRA_LIFE: lives = max(lives,0) + 1; activeEgg = EGG_EXTRA_LIFE; eggActive = true; eggEnd = Clock::now() + chrono::seconds(1); break;
-        case P_SCORE_BONUS: score += 100; activeEgg = EGG_SCORE_BONUS; eggActive = true; eggEnd = Clock::now() + chrono::seconds(1); break;
-        case P_ENLARGE_PADDLE: savedPaddleW = paddleW; paddleW *= 1.6f; paddleX = clampf(paddleX,0.0f,(float)windowWidth-paddleW); activeEgg = EGG_ENLARGE_PADDLE; eggActive = true; eggEnd = Clock::now()+chrono::seconds(10); break;
-        case P_SLOW_MOTION: speedMultiplier = 0.55f; activeEgg = EGG_SLOW_MOTION; eggActive = true; eggEnd = Clock::now()+chrono::seconds(10); break;
-        case P_FAST_MOTION: speedMultiplier = 1.55f; activeEgg = EGG_FAST_MOTION; eggActive = true; eggEnd = Clock::now()+chrono::seconds(10); break;
+        case P_EXTRA_LIFE: lives = max(lives,0) + 1; activeEgg = EGG_EXTRA_LIFE; eggActive = true; eggEnd = gameNow() + chrono::seconds(1); break;
+        case P_SCORE_BONUS: score += 100; activeEgg = EGG_SCORE_BONUS; eggActive = true; eggEnd = gameNow() + chrono::seconds(1); break;
+        case P_ENLARGE_PADDLE: savedPaddleW = paddleW; paddleW *= 1.6f; paddleX = clampf(paddleX,0.0f,(float)windowWidth-paddleW); activeEgg = EGG_ENLARGE_PADDLE; eggActive = true; eggEnd = gameNow()+chrono::seconds(10); break;
+        case P_SLOW_MOTION: speedMultiplier = 0.55f; activeEgg = EGG_SLOW_MOTION; eggActive = true; eggEnd = gameNow()+chrono::seconds(10); break;
+        case P_FAST_MOTION: speedMultiplier = 1.55f; activeEgg = EGG_FAST_MOTION; eggActive = true; eggEnd = gameNow()+chrono::seconds(10); break;
         case P_MULTIBALL:
             // spawn 2 extra free balls
             if (!balls.empty()) {
                 Ball base = balls.front();
-                for (int i=0;i<2;i++) {
+                for (int i=0;i<2 && (int)balls.size()<MAX_BALLS;i++) {
                     Ball nb = base;
                     nb.sx = base.sx * (i==0?1.0f:-1.0f) * 1.2f;
                     nb.sy = base.sy * 0.9f;
@@ -298,15 +506,18 @@ void applyPickupEffect(PickupType t) {
                     balls.push_back(nb);
                 }
             }
-            activeEgg = EGG_MULTIBALL; eggActive = true; eggEnd = Clock::now()+chrono::seconds(6);
+            activeEgg = EGG_MULTIBALL; eggActive = true; eggEnd = gameNow()+chrono::seconds(6);
             break;
-        case P_LASER: laserEnabled = true; activeEgg = EGG_LASER; eggActive = true; eggEnd = Clock::now()+chrono::seconds(12); break;
-        case P_GRAB_PADDLE: grabActive = true; activeEgg = EGG_GRAB_PADDLE; eggActive = true; eggEnd = Clock::now()+chrono::seconds(12); break;
-        case P_MEGA_BALL: lives += 1; for (auto &b: balls) { b.mega = true; b.r *= 1.9f; } laserEnabled=false; speedMultiplier=1.0f; activeEgg = EGG_MEGA_BALL; eggActive=true; eggEnd=Clock::now()+chrono::seconds(8); break;
-        case P_ZAP_BRICK: for (int i=0;i<BR_ROWS*BR_COLS;i++) bricks[i].unbreakable = false; activeEgg = EGG_ZAP_BRICK; eggActive=true; eggEnd=Clock::now()+chrono::seconds(1); break;
-        case P_SHRINK_PADDLE: savedPaddleW = paddleW; paddleW *= 0.55f; paddleX = clampf(paddleX,0.0f,(float)windowWidth-paddleW); activeEgg = EGG_SHRINK_PADDLE; eggActive=true; eggEnd=Clock::now()+chrono::seconds(10); break;
-        case P_FAST_BALL: speedMultiplier *= 1.9f; activeEgg = EGG_FAST_BALL; eggActive=true; eggEnd=Clock::now()+chrono::seconds(10); break;
-        case P_GRAVITY_BALL: speedMultiplier *= 0.6f; for (auto &b: balls) b.gravitySlow = true; activeEgg = EGG_GRAVITY_BALL; eggActive=true; eggEnd=Clock::now()+chrono::seconds(10); break;
+        case P_LASER: laserEnabled = true; activeEgg = EGG_LASER; eggActive = true; eggEnd = gameNow()+chrono::seconds(12); break;
+        case P_GRAB_PADDLE: grabActive = true; activeEgg = EGG_GRAB_PADDLE; eggActive = true; eggEnd = gameNow()+chrono::seconds(12); break;
+        case P_MEGA_BALL: lives += 1; for (auto &b: balls) { b.mega = true; b.r *= 1.9f; } laserEnabled=false; speedMultiplier=1.0f; activeEgg = EGG_MEGA_BALL; eggActive=true; eggEnd=gameNow()+chrono::seconds(8); break;
+        case P_ZAP_BRICK:
+            for (int i=0;i<BR_ROWS*BR_COLS;i++) bricks[i].unbreakable = false;
+            for (int k=0;k<activeChunkCount;k++) for (auto &b: chunkPool[activeChunks[k]].bricks) b.unbreakable = false;
+            activeEgg = EGG_ZAP_BRICK; eggActive=true; eggEnd=gameNow()+chrono::seconds(1); break;
+        case P_SHRINK_PADDLE: savedPaddleW = paddleW; paddleW *= 0.55f; paddleX = clampf(paddleX,0.0f,(float)windowWidth-paddleW); activeEgg = EGG_SHRINK_PADDLE; eggActive=true; eggEnd=gameNow()+chrono::seconds(10); break;
+        case P_FAST_BALL: speedMultiplier *= 1.9f; activeEgg = EGG_FAST_BALL; eggActive=true; eggEnd=gameNow()+chrono::seconds(10); break;
+        case P_GRAVITY_BALL: speedMultiplier *= 0.6f; for (auto &b: balls) b.gravitySlow = true; activeEgg = EGG_GRAVITY_BALL; eggActive=true; eggEnd=gameNow()+chrono::seconds(10); break;
         default: break;
     }
 }
@@ -321,7 +532,7 @@ void triggerEgg(int brickIndex) {
 
 void maybeRevertEggs() {
     if (!eggActive) return;
-    if (Clock::now() >= eggEnd) {
+    if (gameNow() >= eggEnd) {
         if (activeEgg == EGG_ENLARGE_PADDLE || activeEgg == EGG_SHRINK_PADDLE) {
             paddleW = savedPaddleW;
             paddleX = clampf(paddleX, 0.0f, (float)windowWidth - paddleW);
@@ -337,6 +548,174 @@ void maybeRevertEggs() {
     }
 }
 
+// --- Endless mode streaming ---
+int chunkRand(unsigned int &s) { s = s * 1103515245u + 12345u; return (int)((s >> 16) & 0x7fff); }
+
+// place a chunk's bricks on the given grid (keeps alive/golden/unbreakable flags)
+void layoutChunk(EndlessChunk &c, const ChunkLayout &L) {
+    c.x0 = L.x0; c.colPitch = L.colPitch; c.rowPitch = L.rowPitch;
+    c.h = CHUNK_ROWS * L.rowPitch;
+    for (int r = 0; r < CHUNK_ROWS; ++r) {
+        for (int col = 0; col < BR_COLS; ++col) {
+            Brick &b = c.bricks[r * BR_COLS + col];
+            b.x = L.x0 + col * L.colPitch; b.y = r * L.rowPitch; b.w = L.brickW; b.h = L.brickH;
+        }
+    }
+}
+
+// procedural rows; runs on the worker thread, so it only touches the chunk and its arguments
+void generateChunk(EndlessChunk &c, int index, const ChunkLayout &L, unsigned int seed) {
+    unsigned int rs = seed ^ ((unsigned int)index * 2654435761u);
+    c.index = index;
+    layoutChunk(c, L);
+    c.alive = 0;
+    int style = chunkRand(rs) % 3;
+    int density = 45 + min(index * 3, 40); // deeper chunks are denser
+    for (int r = 0; r < CHUNK_ROWS; ++r) {
+        for (int col = 0; col < BR_COLS; ++col) {
+            Brick &b = c.bricks[r * BR_COLS + col];
+            if (style == 1) b.alive = ((r + col) % 2 == 0) || chunkRand(rs) % 100 < density / 3;
+            else if (style == 2) b.alive = (col % 2 == 0) || chunkRand(rs) % 100 < density / 3;
+            else b.alive = chunkRand(rs) % 100 < density;
+            b.unbreakable = b.alive && chunkRand(rs) % 100 < 5;
+            b.golden = b.alive && !b.unbreakable && chunkRand(rs) % 100 < 4;
+            if (b.alive) c.alive++;
+        }
+    }
+}
+
+void chunkWorkerLoop() {
+    unique_lock<mutex> lk(chunkMutex);
+    while (!chunkWorkerStop) {
+        int slot = -1;
+        for (int i = 0; i < CHUNK_POOL; ++i) if (chunkPool[i].status == CHUNK_FREE) { slot = i; break; }
+        if (slot < 0) { chunkCv.wait(lk); continue; }
+        EndlessChunk &c = chunkPool[slot];
+        c.status = CHUNK_LOADING;
+        int index = nextChunkToGenerate++;
+        ChunkLayout L = chunkLayout;
+        unsigned int seed = endlessSeed;
+        lk.unlock();
+        generateChunk(c, index, L, seed);
+        lk.lock();
+        c.status = CHUNK_READY;
+    }
+}
+
+void stopEndlessStreaming() {
+    if (!chunkWorker.joinable()) return;
+    { lock_guard<mutex> lk(chunkMutex); chunkWorkerStop = true; }
+    chunkCv.notify_all();
+    chunkWorker.join();
+}
+
+void captureChunkLayout() {
+    // same column geometry as the classic field (see recomputeLayout)
+    lock_guard<mutex> lk(chunkMutex);
+    chunkLayout.x0 = bricks[0].x;
+    chunkLayout.colPitch = bricks[1].x - bricks[0].x;
+    chunkLayout.brickW = bricks[0].w;
+    chunkLayout.brickH = bricks[0].h;
+    chunkLayout.rowPitch = bricks[BR_COLS].y - bricks[0].y;
+}
+
+// place the next chunk above the current top one; false if the worker has not produced it yet
+bool activateNextChunk() {
+    lock_guard<mutex> lk(chunkMutex);
+    for (int i = 0; i < CHUNK_POOL; ++i) {
+        EndlessChunk &c = chunkPool[i];
+        if (c.status != CHUNK_READY || c.index != nextChunkToActivate) continue;
+        layoutChunk(c, chunkLayout); // the window may have been resized since it was generated
+        float top = activeChunkCount ? chunkPool[activeChunks[activeChunkCount-1]].y : windowHeight * 0.08f + c.h;
+        c.y = top - c.h;
+        c.status = CHUNK_ACTIVE;
+        activeChunks[activeChunkCount++] = i;
+        nextChunkToActivate++;
+        return true;
+    }
+    return false;
+}
+
+void freeBottomChunk() {
+    {
+        lock_guard<mutex> lk(chunkMutex);
+        chunkPool[activeChunks[0]].status = CHUNK_FREE;
+    }
+    for (int k = 1; k < activeChunkCount; ++k) activeChunks[k-1] = activeChunks[k];
+    activeChunkCount--;
+    endlessDepth++;
+    chunkCv.notify_one();
+}
+
+void startEndless() {
+    stopEndlessStreaming();
+    startNewGame();
+    endlessMode = true;
+    setAllBricksAlive(false);
+    endlessDepth = 0;
+    endlessScrollSpeed = windowHeight * 0.0005f;
+    endlessSeed = (unsigned int)gameRand() * 7919u + 1u;
+    for (auto &c: chunkPool) c.status = CHUNK_FREE;
+    activeChunkCount = 0;
+    nextChunkToGenerate = 2; nextChunkToActivate = 0;
+    captureChunkLayout();
+    // first two chunks synchronously so the opening screen is never empty
+    for (int i = 0; i < 2; ++i) { generateChunk(chunkPool[i], i, chunkLayout, endlessSeed); chunkPool[i].status = CHUNK_READY; }
+    while (activateNextChunk()) {}
+    chunkWorkerStop = false;
+    chunkWorker = thread(chunkWorkerLoop);
+    static bool exitHook = false;
+    if (!exitHook) { atexit(stopEndlessStreaming); exitHook = true; }
+}
+
+// window resized: move chunks in play onto the new grid, keeping their place on screen
+void relayoutEndlessChunks(int oldHeight) {
+    captureChunkLayout();
+    endlessScrollSpeed = windowHeight * 0.0005f;
+    float scale = windowHeight / (float)oldHeight;
+    for (int k = 0; k < activeChunkCount; ++k) {
+        EndlessChunk &c = chunkPool[activeChunks[k]];
+        // bottom chunk keeps its relative position; the rest stack on top of it as before
+        c.y = k == 0 ? c.y * scale : chunkPool[activeChunks[k-1]].y;
+        layoutChunk(c, chunkLayout);
+        if (k > 0) c.y -= c.h;
+    }
+}
+
+// scroll the field, stream chunks in above the screen and free the ones below it
+void updateEndlessChunks() {
+    for (int k = 0; k < activeChunkCount; ++k) chunkPool[activeChunks[k]].y += endlessScrollSpeed;
+    while (activeChunkCount > 0 && chunkPool[activeChunks[0]].y > windowHeight) freeBottomChunk();
+    // keep one chunk staged above the viewport
+    while (activeChunkCount == 0 || chunkPool[activeChunks[activeChunkCount-1]].y > -chunkPool[activeChunks[activeChunkCount-1]].h) {
+        if (!activateNextChunk()) break;
+    }
+}
+
+// first alive brick overlapping the box, searching only chunks and rows/cols the box covers
+Brick *endlessBrickAt(float l, float t, float r, float b, float &brickY, EndlessChunk *&owner) {
+    for (int k = 0; k < activeChunkCount; ++k) {
+        EndlessChunk &c = chunkPool[activeChunks[k]];
+        if (b <= c.y || t >= c.y + c.h) continue;
+        int r0 = max(0, (int)floorf((t - c.y) / c.rowPitch)), r1 = min(CHUNK_ROWS - 1, (int)floorf((b - c.y) / c.rowPitch));
+        int c0 = max(0, (int)floorf((l - c.x0) / c.colPitch)), c1 = min(BR_COLS - 1, (int)floorf((r - c.x0) / c.colPitch));
+        for (int row = r0; row <= r1; ++row) {
+            for (int col = c0; col <= c1; ++col) {
+                Brick &br = c.bricks[row * BR_COLS + col];
+                if (!br.alive) continue;
+                float by = c.y + br.y;
+                if (r > br.x && l < br.x + br.w && b > by && t < by + br.h) { brickY = by; owner = &c; return &br; }
+            }
+        }
+    }
+    return nullptr;
+}
+
+void breakEndlessBrick(Brick &br, float brickY, EndlessChunk &owner) {
+    br.alive = false; br.golden = false; owner.alive--; score += 10; playPip();
+    spawnPickupAt(br.x + br.w*0.5f, brickY + br.h*0.5f);
+}
+
 // --- Drawing helpers ---
 void drawRect(float x, float y, float w, float h) {
     glBegin(GL_QUADS);
@@ -349,25 +728,31 @@ void drawRect(float x, float y, float w, float h) {
 void drawCircle(float cx, float cy, float r) {
     glBegin(GL_TRIANGLE_FAN);
     glVertex2f(cx, cy);
-    const int SEG = 36;
+    const int SEG = quality().circleSeg;
     for (int i = 0; i <= SEG; ++i) {
         float a = i / (float)SEG * 2.0f * 3.14159265f;
         glVertex2f(cx + cosf(a) * r, cy + sinf(a) * r);
     }
     glEnd();
 }
-void drawText(float x, float y, const string &s) {
+void drawText(float x, float y, const char *s) {
+    if (headless) return; // GLUT aborts without glutInit; plain GL calls are no-ops without a context
     glRasterPos2f(x, y);
-    for (char c : s) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, c);
+    for (; *s; ++s) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *s);
 }
 
 // --- Draw game objects ---
+const char *hudText() {
+    if (endlessMode)
+        return frameFmt("Score: %d  Lives: %d  Depth: %d  High: %d", score, lives, endlessDepth, highScore);
+    return frameFmt("Score: %d  Lives: %d  Level: %d  High: %d", score, lives, currentLevel, highScore);
+}
+
 void drawHUD() {
     glColor3f(1,1,1);
-    string s = "Score: " + to_string(score) + "  Lives: " + to_string(lives) + "  Level: " + to_string(currentLevel) + "  High: " + to_string(highScore);
-    drawText(10.0f, 20.0f, s);
+    drawText(10.0f, 20.0f, hudText());
     if (eggActive && activeEgg != EGG_NONE) {
-        string es;
+        const char *es;
         switch (activeEgg) {
     // 💚 Beneficial pickups (Green)
     case EGG_EXTRA_LIFE:
@@ -437,47 +822,76 @@ void drawHUD() {
         break;
 }
 
-        if (!es.empty()) drawText(10.0f, 40.0f, es);
+        if (*es) drawText(10.0f, 40.0f, es);
     }
 }
-void drawBricks() {
-    for (int i = 0; i < BR_ROWS * BR_COLS; ++i) {
-        if (!bricks[i].alive) continue;
-        int row = i / BR_COLS;
-        if (bricks[i].golden) {
-            glColor3f(0.95f,0.8f,0.18f);
-        } else {
-            switch (row % 5) {
-                case 0: glColor3f(0.86f,0.31f,0.31f); break;
-                case 1: glColor3f(0.31f,0.86f,0.47f); break;
-                case 2: glColor3f(0.31f,0.55f,0.86f); break;
-                case 3: glColor3f(0.86f,0.78f,0.31f); break;
-                default: glColor3f(0.7f,0.31f,0.86f); break;
-            }
+
+// debug overlay (toggle with 'D')
+void drawDebugOverlay() {
+    glColor3f(0.6f,1.0f,0.6f);
+    drawText(10.0f, windowHeight - 30.0f,
+             frameFmt("Quality: %d %s  Render: %.1fms  Interval: %.1fms  Tick: %.1fms  Balls: %d", qualityLevel, quality().name, frameWorkMs, frameIntervalMs, lastUpdateMs, (int)balls.size()));
+    drawText(10.0f, windowHeight - 10.0f,
+             frameFmt("Allocs/tick: %zu  Allocs/frame: %zu", allocsLastTick, allocsLastFrame));
+}
+void drawBrick(const Brick &br, float y, int row) {
+    if (br.golden) {
+        glColor3f(0.95f,0.8f,0.18f);
+    } else {
+        switch (row % 5) {
+            case 0: glColor3f(0.86f,0.31f,0.31f); break;
+            case 1: glColor3f(0.31f,0.86f,0.47f); break;
+            case 2: glColor3f(0.31f,0.55f,0.86f); break;
+            case 3: glColor3f(0.86f,0.78f,0.31f); break;
+            default: glColor3f(0.7f,0.31f,0.86f); break;
         }
-        drawRect(bricks[i].x, bricks[i].y, bricks[i].w, bricks[i].h);
-        // border
+    }
+    drawRect(br.x, y, br.w, br.h);
+    // border (dropped at low quality)
+    if (quality().brickBorders) {
         glColor3f(0.04f,0.04f,0.06f);
         glBegin(GL_LINE_LOOP);
-          glVertex2f(bricks[i].x, bricks[i].y);
-          glVertex2f(bricks[i].x + bricks[i].w, bricks[i].y);
-          glVertex2f(bricks[i].x + bricks[i].w, bricks[i].y + bricks[i].h);
-          glVertex2f(bricks[i].x, bricks[i].y + bricks[i].h);
+          glVertex2f(br.x, y);
+          glVertex2f(br.x + br.w, y);
+          glVertex2f(br.x + br.w, y + br.h);
+          glVertex2f(br.x, y + br.h);
         glEnd();
+    }
 
-        // indicate unbreakable
-        if (bricks[i].unbreakable) {
-            glColor3f(0.2f,0.2f,0.2f);
-            drawText(bricks[i].x + 6, bricks[i].y + bricks[i].h*0.5f, "#");
-        }
+    // indicate unbreakable
+    if (br.unbreakable) {
+        glColor3f(0.2f,0.2f,0.2f);
+        drawText(br.x + 6, y + br.h*0.5f, "#");
+    }
 
-        if (bricks[i].golden) {
-            float cx = bricks[i].x + bricks[i].w * 0.5f;
-            float cy = bricks[i].y + bricks[i].h * 0.5f;
-            float r = min(bricks[i].w, bricks[i].h) * 0.18f;
-            glColor3f(1.0f, 0.9f, 0.2f);
-            drawCircle(cx, cy, r);
-        }
+    if (br.golden) {
+        float cx = br.x + br.w * 0.5f;
+        float cy = y + br.h * 0.5f;
+        float r = min(br.w, br.h) * 0.18f;
+        glColor3f(1.0f, 0.9f, 0.2f);
+        drawCircle(cx, cy, r);
+    }
+}
+
+// endless mode: only chunks and rows inside the viewport are drawn
+void drawEndlessBricks() {
+    for (int k = 0; k < activeChunkCount; ++k) {
+        const EndlessChunk &c = chunkPool[activeChunks[k]];
+        if (c.y >= windowHeight || c.y + c.h <= 0.0f) continue;
+        int r0 = max(0, (int)floorf(-c.y / c.rowPitch)), r1 = min(CHUNK_ROWS - 1, (int)floorf((windowHeight - c.y) / c.rowPitch));
+        for (int row = r0; row <= r1; ++row)
+            for (int col = 0; col < BR_COLS; ++col) {
+                const Brick &br = c.bricks[row * BR_COLS + col];
+                if (br.alive) drawBrick(br, c.y + br.y, c.index * CHUNK_ROWS + row);
+            }
+    }
+}
+
+void drawBricks() {
+    if (endlessMode) { drawEndlessBricks(); return; }
+    for (int i = 0; i < BR_ROWS * BR_COLS; ++i) {
+        if (!bricks[i].alive) continue;
+        drawBrick(bricks[i], bricks[i].y, i / BR_COLS);
     }
 }
 
@@ -488,9 +902,10 @@ void drawPickups() {
         float r = 10.0f;
         glColor3f(0.95f,0.95f,0.95f);
         drawCircle(p.x, p.y, r);
+        if (!quality().pickupLabels) continue;
         // try to draw emoji (may not render on all systems), also draw short ASCII label
         glColor3f(0,0,0);
-        string txt = p.emoji.empty() ? shortLabelFor(p.type) : p.emoji + " " + shortLabelFor(p.type);
+        const char *txt = *p.emoji ? frameFmt("%s %s", p.emoji, shortLabelFor(p.type)) : shortLabelFor(p.type);
         drawText(p.x - 8.0f, p.y + 5.0f, txt);
     }
 }
@@ -506,7 +921,7 @@ void drawMenu() {
 
     for (int i = 0; i < MENU_ITEMS; ++i) {
         float y = startY + i * (boxH + windowHeight * 0.02f);
-        bool enabled = !(i == 1 && !resumeAvailable());
+        bool enabled = !(i == 2 && !resumeAvailable());
         glColor3f(enabled ? 0.2f : 0.4f, 0.5f, 0.9f);
         drawRect(cx, y, boxW, boxH);
         glColor3f(1,1,1);
@@ -518,12 +933,14 @@ void drawHighScoreScreen() {
     glClear(GL_COLOR_BUFFER_BIT);
     glColor3f(1,1,1);
     drawText(windowWidth * 0.5f - 60, windowHeight * 0.25f, "HIGH SCORE");
-    drawText(windowWidth * 0.5f - 80, windowHeight * 0.35f, string("Best: ") + to_string(highScore));
+    drawText(windowWidth * 0.5f - 80, windowHeight * 0.35f, frameFmt("Best: %d", highScore));
     drawText(windowWidth * 0.5f - 140, windowHeight * 0.6f, "Click anywhere to return to menu.");
 }
 
 // --- Display ---
-void display() {
+// everything display() does except the swap, so --alloc-check can run it without a window
+void drawFrame() {
+    Clock::time_point frameStart = Clock::now();
     glClear(GL_COLOR_BUFFER_BIT);
 
     drawBricks();
@@ -550,15 +967,273 @@ void display() {
     }
 
     drawHUD();
+    if (showDebug) drawDebugOverlay();
 
     if (state == STATE_MENU) drawMenu();
     else if (state == STATE_HIGHSCORE) drawHighScoreScreen();
 
+    // measure before the swap so vsync waits are not counted as render cost
+    float renderMs = chrono::duration<float, milli>(Clock::now() - frameStart).count();
+    float intervalMs = lastFrameStart == Clock::time_point() ? 0.0f
+                     : chrono::duration<float, milli>(frameStart - lastFrameStart).count();
+    lastFrameStart = frameStart;
+    governQuality(renderMs, max(0.0f, intervalMs - lastUpdateMs));
+}
+
+void display() {
+#ifdef DXBALL_TRACK_ALLOCS
+    size_t allocsAtStart = allocCount.load(memory_order_relaxed);
+#endif
+    drawFrame();
     glutSwapBuffers();
+#ifdef DXBALL_TRACK_ALLOCS
+    allocsLastFrame = allocCount.load(memory_order_relaxed) - allocsAtStart;
+#endif
+    frameArenaReset();
+}
+
+// --- Ball-ball collisions ---
+// Sweep-and-prune on x: balls move little per tick, so insertion sort on last tick's
+// order is close to linear. Only pairs whose x-intervals overlap reach the circle test.
+void syncSapOrder() {
+    int n = (int)balls.size();
+    if ((int)sapOrder.size() != n) {
+        // balls were added/removed: drop stale indices, append new ones
+        int w = 0;
+        for (int k = 0; k < (int)sapOrder.size(); ++k) if (sapOrder[k] < n) sapOrder[w++] = sapOrder[k];
+        sapOrder.resize(w);
+        sapSeen.assign(n, 0);
+        for (int k = 0; k < w; ++k) sapSeen[sapOrder[k]] = 1;
+        for (int i = 0; i < n; ++i) if (!sapSeen[i]) sapOrder.push_back(i);
+    }
+}
+
+// the separation push runs after the wall pass, so it must not leave a ball outside the field
+void clampBallToWalls(Ball &ball) {
+    ball.x = clampf(ball.x, ball.r, windowWidth - ball.r);
+    if (ball.y < ball.r) ball.y = ball.r;
+}
+
+void resolveBallPair(Ball &a, Ball &b) {
+    float dx = b.x - a.x, dy = b.y - a.y;
+    float rr = a.r + b.r;
+    float d2 = dx*dx + dy*dy;
+    if (d2 >= rr*rr || d2 <= 1e-8f) return;
+    float d = sqrtf(d2);
+    float nx = dx / d, ny = dy / d;
+    // mass ~ area, so a mega ball shoves normal balls aside
+    float ia = 1.0f / (a.r*a.r), ib = 1.0f / (b.r*b.r);
+    // push apart along the normal, split by inverse mass
+    float push = (rr - d) / (ia + ib);
+    a.x -= nx * push * ia; a.y -= ny * push * ia;
+    b.x += nx * push * ib; b.y += ny * push * ib;
+    clampBallToWalls(a); clampBallToWalls(b);
+    // elastic impulse, only if still approaching
+    float vn = (a.sx - b.sx) * nx + (a.sy - b.sy) * ny;
+    if (vn <= 0.0f) return;
+    float j = 2.0f * vn / (ia + ib);
+    a.sx -= j * ia * nx; a.sy -= j * ia * ny;
+    b.sx += j * ib * nx; b.sy += j * ib * ny;
+}
+
+void collideBalls() {
+    syncSapOrder();
+    int n = (int)sapOrder.size();
+    // incremental insertion sort by left edge
+    for (int k = 1; k < n; ++k) {
+        int idx = sapOrder[k];
+        float key = balls[idx].x - balls[idx].r;
+        int m = k - 1;
+        while (m >= 0 && balls[sapOrder[m]].x - balls[sapOrder[m]].r > key) { sapOrder[m+1] = sapOrder[m]; --m; }
+        sapOrder[m+1] = idx;
+    }
+    // sweep
+    for (int k = 0; k < n; ++k) {
+        Ball &a = balls[sapOrder[k]];
+        if (a.stuck) continue;
+        float maxX = a.x + a.r;
+        for (int m = k + 1; m < n; ++m) {
+            Ball &b = balls[sapOrder[m]];
+            if (b.x - b.r > maxX) break;
+            if (b.stuck) continue;
+            if (fabs(b.y - a.y) >= a.r + b.r) continue;
+            resolveBallPair(a, b);
+        }
+    }
+}
+
+// --- Ball update (split across a worker pool for ball-heavy ticks) ---
+// Phase 1 runs in parallel: each ball moves and is tested against walls, paddle and bricks,
+// reading but never writing shared state; what it hit goes into its own result slot.
+// Phase 2 runs serially in ball order and applies those hits, so a brick hit by two balls
+// breaks and scores once, and results do not depend on how many threads ran phase 1.
+struct BallTickResult { Brick *brick; EndlessChunk *chunk; float brickY; bool paddleHit; bool lost; };
+BallTickResult ballResults[MAX_BALLS];
+const int MAX_BALL_THREADS = 64;
+int ballThreads = 1;                  // worker count incl. the game thread; set in main()
+// below this many balls per thread, syncing costs more than it saves. Phase 1 costs ~0.14 us
+// a ball and a split round trip ~5 us (break-even ~35 balls a part); 256 leaves room for a
+// slower cross-core wake-up
+const int BALLS_PER_THREAD_MIN = 256;
+vector<thread> ballPool;
+mutex ballPoolMutex;
+// one wake-up per worker, so a job split in fewer parts than the pool only wakes the workers it uses
+condition_variable ballWorkerCv[MAX_BALL_THREADS], ballPoolDoneCv;
+int ballJobGeneration = 0, ballJobPending = 0, ballJobParts = 0, ballJobCount = 0;
+bool ballPoolStop = false;
+
+void bounceOffPaddle(Ball &ball) {
+    ball.sy = -fabs(ball.sy);
+    float hitPos = (ball.x - (paddleX + paddleW * 0.5f)) / (paddleW * 0.5f);
+    ball.sx = hitPos * (0.4f * (min(windowWidth, windowHeight) / 600.0f));
+}
+
+void moveBallRange(int begin, int end) {
+    for (int bi = begin; bi < end; ++bi) {
+        Ball &ball = balls[bi];
+        BallTickResult &res = ballResults[bi];
+        res.brick = nullptr; res.chunk = nullptr; res.paddleHit = false; res.lost = false;
+        if (ball.stuck) continue; // stays on paddle
+        float effectiveSpeed = 10.0f * speedMultiplier * (ball.gravitySlow?0.7f:1.0f);
+        ball.x += ball.sx * effectiveSpeed;
+        ball.y += ball.sy * effectiveSpeed;
+
+        // wall collisions
+        if (ball.x - ball.r < 0.0f) { ball.x = ball.r; ball.sx = -ball.sx; }
+        if (ball.x + ball.r > windowWidth) { ball.x = windowWidth - ball.r; ball.sx = -ball.sx; }
+        if (ball.y - ball.r < 0.0f) { ball.y = ball.r; ball.sy = -ball.sy; }
+
+        // paddle collision (grab only catches one ball, so that case is settled in the merge)
+        if (ball.y + ball.r >= paddleY && ball.y - ball.r <= paddleY + paddleH &&
+            ball.x >= paddleX && ball.x <= paddleX + paddleW) {
+            if (grabActive) res.paddleHit = true;
+            else bounceOffPaddle(ball);
+        }
+
+        // bricks collision: remember the first brick touched and bounce
+        if (endlessMode) {
+            res.brick = endlessBrickAt(ball.x - ball.r, ball.y - ball.r, ball.x + ball.r, ball.y + ball.r, res.brickY, res.chunk);
+        } else {
+            for (int i = 0; i < BR_ROWS * BR_COLS; ++i) {
+                if (!bricks[i].alive) continue;
+                float bx = bricks[i].x, by = bricks[i].y, bw = bricks[i].w, bh = bricks[i].h;
+                if (ball.x + ball.r > bx && ball.x - ball.r < bx + bw &&
+                    ball.y + ball.r > by && ball.y - ball.r < by + bh) {
+                    res.brick = &bricks[i]; res.brickY = by;
+                    break;
+                }
+            }
+        }
+        if (res.brick) ball.sy = -ball.sy;
+
+        // lose life (ball below bottom)
+        res.lost = ball.y - ball.r > windowHeight;
+    }
+}
+
+void mergeBallResults(int n) {
+    for (int bi = 0; bi < n; ++bi) {
+        Ball &ball = balls[bi];
+        const BallTickResult &res = ballResults[bi];
+        if (res.paddleHit) {
+            // if grab active, stick ball to paddle
+            if (grabActive) {
+                ball.stuck = true;
+                ball.x = paddleX + paddleW*0.5f;
+                ball.y = paddleY - ball.r - windowHeight*0.005f;
+                grabActive = false; // only catch once
+            } else {
+                bounceOffPaddle(ball);
+            }
+        }
+        Brick *br = res.brick;
+        // an earlier ball may already have broken it this tick
+        if (br && br->alive && (!br->unbreakable || ball.mega || activeEgg==EGG_ZAP_BRICK)) {
+            if (res.chunk) breakEndlessBrick(*br, res.brickY, *res.chunk);
+            else {
+                float spawnX = br->x + br->w*0.5f;
+                float spawnY = br->y + br->h*0.5f;
+                br->alive = false; br->golden = false; bricks_alive--; score += 10; playPip();
+                // spawn pickup on ANY broken brick (chance inside spawnPickupAt)
+                spawnPickupAt(spawnX, spawnY);
+            }
+        }
+    }
+
+    // drop balls that fell out, keeping order
+    int w = 0;
+    for (int bi = 0; bi < n; ++bi) if (!ballResults[bi].lost) balls[w++] = balls[bi];
+    if (w == n) return;
+    balls.resize(w);
+    if (balls.empty()) {
+        lives--;
+        if (score > highScore) highScore = score;
+        if (lives <= 0) {
+            state = STATE_MENU; gameStarted = false;
+            if (endlessMode) stopEndlessStreaming();
+        }
+        resetBallsToPaddle();
+    }
+}
+
+// seen: the job generation at spawn time, so a restarted pool does not rerun an old job
+void ballWorkerLoop(int part, int seen) {
+    unique_lock<mutex> lk(ballPoolMutex);
+    for (;;) {
+        ballWorkerCv[part].wait(lk, [&] { return ballPoolStop || (ballJobGeneration != seen && part < ballJobParts); });
+        if (ballPoolStop) return;
+        seen = ballJobGeneration;
+        int parts = ballJobParts, n = ballJobCount;
+        lk.unlock();
+        moveBallRange((int)((long)n * part / parts), (int)((long)n * (part + 1) / parts));
+        lk.lock();
+        if (--ballJobPending == 0) ballPoolDoneCv.notify_one();
+    }
+}
+
+void stopBallPool() {
+    { lock_guard<mutex> lk(ballPoolMutex); ballPoolStop = true; }
+    for (size_t part = 1; part <= ballPool.size(); ++part) ballWorkerCv[part].notify_one();
+    for (auto &t: ballPool) t.join();
+    ballPool.clear();
+    ballPoolStop = false;
+}
+
+// spawning threads allocates, so this runs at startup (after ballThreads is set), never mid-game
+void startBallPool() {
+    ballThreads = max(1, min(MAX_BALL_THREADS, ballThreads));
+    if ((int)ballPool.size() == ballThreads - 1) return;
+    stopBallPool();
+    static bool exitHook = false;
+    if (!exitHook) { atexit(stopBallPool); exitHook = true; }
+    ballPool.reserve(ballThreads - 1);
+    for (int part = 1; part < ballThreads; ++part) ballPool.emplace_back(ballWorkerLoop, part, ballJobGeneration);
+}
+
+void updateBalls() {
+    int n = (int)balls.size();
+    int parts = min((int)ballPool.size() + 1, max(1, n / BALLS_PER_THREAD_MIN));
+    if (parts <= 1) {
+        moveBallRange(0, n);
+    } else {
+        {
+            lock_guard<mutex> lk(ballPoolMutex);
+            ballJobCount = n; ballJobParts = parts;
+            ballJobPending = parts - 1;
+            ballJobGeneration++;
+        }
+        for (int part = 1; part < parts; ++part) ballWorkerCv[part].notify_one();
+        moveBallRange(0, (int)((long)n / parts));
+        unique_lock<mutex> lk(ballPoolMutex);
+        ballPoolDoneCv.wait(lk, [] { return ballJobPending == 0; });
+    }
+    mergeBallResults(n);
 }
 
 // --- Update loop ---
-void update(int value) {
+// one gameplay tick; no GLUT calls so it can also run headless
+void stepGame() {
+    if (headless) simNow += chrono::milliseconds(16);
     maybeRevertEggs();
 
     if (state == STATE_PLAYING) {
@@ -582,6 +1257,14 @@ void update(int value) {
             for (int i = (int)lasers.size()-1; i>=0; --i) {
                 lasers[i].y -= laserSpeed;
                 if (lasers[i].y + lasers[i].h < 0) lasers.erase(lasers.begin()+i);
+                else if (endlessMode) {
+                    float by; EndlessChunk *owner;
+                    Brick *br = endlessBrickAt(lasers[i].x, lasers[i].y, lasers[i].x, lasers[i].y + lasers[i].h, by, owner);
+                    if (br) {
+                        if (!br->unbreakable) breakEndlessBrick(*br, by, *owner);
+                        lasers.erase(lasers.begin()+i);
+                    }
+                }
                 else {
                     // laser-brick collision
                     for (int j=0;j<BR_ROWS*BR_COLS;j++) {
@@ -605,79 +1288,33 @@ void update(int value) {
         }
 
         // update balls
-        for (int bi = (int)balls.size()-1; bi >= 0; --bi) {
-            Ball &ball = balls[bi];
-            if (ball.stuck) continue; // stays on paddle
-            float effectiveSpeed = 10.0f * speedMultiplier * (ball.gravitySlow?0.7f:1.0f);
-            ball.x += ball.sx * effectiveSpeed;
-            ball.y += ball.sy * effectiveSpeed;
-
-            // wall collisions
-            if (ball.x - ball.r < 0.0f) { ball.x = ball.r; ball.sx = -ball.sx; }
-            if (ball.x + ball.r > windowWidth) { ball.x = windowWidth - ball.r; ball.sx = -ball.sx; }
-            if (ball.y - ball.r < 0.0f) { ball.y = ball.r; ball.sy = -ball.sy; }
-
-            // paddle collision
-            if (ball.y + ball.r >= paddleY && ball.y - ball.r <= paddleY + paddleH &&
-                ball.x >= paddleX && ball.x <= paddleX + paddleW) {
-                // if grab active, stick ball to paddle
-                if (grabActive) {
-                    ball.stuck = true;
-                    ball.x = paddleX + paddleW*0.5f;
-                    ball.y = paddleY - ball.r - windowHeight*0.005f;
-                    grabActive = false; // only catch once
-                } else {
-                    ball.sy = -fabs(ball.sy);
-                    float hitPos = (ball.x - (paddleX + paddleW * 0.5f)) / (paddleW * 0.5f);
-                    ball.sx = hitPos * (0.4f * (min(windowWidth, windowHeight) / 600.0f));
-                }
-            }
-
-            // bricks collision
-            for (int i = 0; i < BR_ROWS * BR_COLS; ++i) {
-                if (!bricks[i].alive) continue;
-                float bx = bricks[i].x, by = bricks[i].y, bw = bricks[i].w, bh = bricks[i].h;
-                if (ball.x + ball.r > bx && ball.x - ball.r < bx + bw &&
-                    ball.y + ball.r > by && ball.y - ball.r < by + bh) {
-                    if (!bricks[i].unbreakable || ball.mega || activeEgg==EGG_ZAP_BRICK) {
-                        bool wasGolden = bricks[i].golden;
-                        float spawnX = bricks[i].x + bricks[i].w*0.5f;
-                        float spawnY = bricks[i].y + bricks[i].h*0.5f;
-                        bricks[i].alive = false; bricks[i].golden = false; bricks_alive--; score += 10; playPip();
-                        // spawn pickup on ANY broken brick (chance inside spawnPickupAt)
-                        spawnPickupAt(spawnX, spawnY);
-                    } else {
-                        // bounce off unbreakable
-                    }
-                    ball.sy = -ball.sy;
-                    break;
-                }
-            }
+        updateBalls();
 
-            // lose life (ball below bottom)
-            if (ball.y - ball.r > windowHeight) {
-                // remove this ball
-                balls.erase(balls.begin() + bi);
-                if (balls.empty()) {
-                    lives--;
-                    if (score > highScore) highScore = score;
-                    if (lives <= 0) { state = STATE_MENU; gameStarted = false; }
-                    resetBallsToPaddle();
-                    break;
-                }
-            }
-        }
+        if (ballCollisions) collideBalls();
 
         // move stuck balls with paddle
         for (auto &b: balls) if (b.stuck) { b.x = paddleX + paddleW*0.5f; b.y = paddleY - b.r - windowHeight*0.005f; }
 
+        if (endlessMode) updateEndlessChunks();
+
         // level cleared
-        if (bricks_alive == 0) {
+        if (!endlessMode && bricks_alive == 0) {
             if (score > highScore) highScore = score;
             nextLevel();
         }
     }
+}
 
+void update(int value) {
+    Clock::time_point tickStart = Clock::now();
+#ifdef DXBALL_TRACK_ALLOCS
+    size_t allocsAtStart = allocCount.load(memory_order_relaxed);
+#endif
+    stepGame();
+#ifdef DXBALL_TRACK_ALLOCS
+    allocsLastTick = allocCount.load(memory_order_relaxed) - allocsAtStart;
+#endif
+    lastUpdateMs = chrono::duration<float, milli>(Clock::now() - tickStart).count();
     glutPostRedisplay();
     glutTimerFunc(16, update, 0);
 }
@@ -704,9 +1341,10 @@ void mouseClick(int button, int stateBtn, int x, int y) {
             float bottom = top + boxH;
             if (mx >= cx && mx <= cx + boxW && my >= top && my <= bottom) {
                 if (i == 0) startNewGame();
-                else if (i == 1 && resumeAvailable()) state = STATE_PLAYING;
-                else if (i == 2) state = STATE_HIGHSCORE;
-                else if (i == 3) exit(0);
+                else if (i == 1) startEndless();
+                else if (i == 2 && resumeAvailable()) state = STATE_PLAYING;
+                else if (i == 3) state = STATE_HIGHSCORE;
+                else if (i == 4) exit(0);
             }
         }
     } else if (state == STATE_PLAYING) {
@@ -718,7 +1356,7 @@ void mouseClick(int button, int stateBtn, int x, int y) {
             return;
         }
         // otherwise, left click can fire lasers if enabled
-        if (laserEnabled && button == GLUT_LEFT_BUTTON) {
+        if (laserEnabled && button == GLUT_LEFT_BUTTON && (int)lasers.size() < MAX_LASERS) {
             Laser L; L.x = paddleX + paddleW*0.5f; L.y = paddleY; L.h = 6.0f; lasers.push_back(L);
         }
     } else if (state == STATE_HIGHSCORE) {
@@ -738,12 +1376,17 @@ void keyboard(unsigned char key, int x, int y) {
             for (auto &b: balls) if (b.stuck) { b.stuck = false; b.sy = -fabs(b.sy); }
         }
     } else if (key == 'f' || key == 'F') {
-        if (laserEnabled) { Laser L; L.x = paddleX + paddleW*0.5f; L.y = paddleY; L.h = 6.0f; lasers.push_back(L); }
+        if (laserEnabled && (int)lasers.size() < MAX_LASERS) { Laser L; L.x = paddleX + paddleW*0.5f; L.y = paddleY; L.h = 6.0f; lasers.push_back(L); }
+    } else if (key == 'd' || key == 'D') {
+        showDebug = !showDebug;
+    } else if (key == 'b' || key == 'B') {
+        ballCollisions = !ballCollisions;
     }
 }
 
 // --- Reshape: use window size as logical coords
 void reshape(int w, int h) {
+    int oldHeight = windowHeight;
     windowWidth = (w > 100 ? w : 100);
     windowHeight = (h > 80 ? h : 80);
 
@@ -755,20 +1398,344 @@ void reshape(int w, int h) {
     glLoadIdentity();
 
     recomputeLayout();
-    if (bricks_alive == 0) loadLevelPattern(currentLevel);
+    if (endlessMode) relayoutEndlessChunks(oldHeight);
+    else if (bricks_alive == 0) loadLevelPattern(currentLevel);
 }
 
 // --- Init ---
+void reserveGameBuffers() {
+    balls.reserve(MAX_BALLS);
+    pickups.reserve(MAX_PICKUPS);
+    lasers.reserve(MAX_LASERS);
+    sapOrder.reserve(MAX_BALLS);
+    sapSeen.reserve(MAX_BALLS);
+}
+
 void initGL() {
     glClearColor(0.05f, 0.05f, 0.1f, 1.0f);
+    reserveGameBuffers();
+    startBallPool();
     recomputeLayout();
     loadLevelPattern(currentLevel);
     resetBallsToPaddle();
 }
 
+#ifdef DXBALL_TRACK_ALLOCS
+// --- Allocation check: plays headless and fails if a steady-state tick or frame allocates ---
+int runAllocCheck() {
+    headless = true;
+    ballCollisions = true; // cover the optional path too
+    rngState = 1234;
+    reserveGameBuffers();
+    recomputeLayout();
+    startNewGame();
+
+    showDebug = true;      // and the debug overlay
+    const int WARMUP_TICKS = 600, CHECK_TICKS = 20000;
+    size_t worstTick = 0, tickTotal = 0, worstFrame = 0, frameTotal = 0;
+    for (int t = 0; t < WARMUP_TICKS + CHECK_TICKS; ++t) {
+        if (state != STATE_PLAYING) startNewGame();
+        for (auto &b: balls) if (b.stuck) { b.stuck = false; b.sy = -fabs(b.sy); }
+        // paddle follows the first ball so the run keeps going
+        if (!balls.empty()) paddleX = clampf(balls.front().x - paddleW*0.5f, 0.0f, (float)windowWidth - paddleW);
+
+        size_t before = allocCount.load(memory_order_relaxed);
+        stepGame();
+        size_t n = allocCount.load(memory_order_relaxed) - before;
+        if (t >= WARMUP_TICKS) { tickTotal += n; worstTick = max(worstTick, n); }
+
+        // the real draw path; every few frames also draw the menu / high-score overlays
+        qualityLevel = QUALITY_LEVELS - 1; // full quality draws the most (pickup labels etc.)
+        GameState playing = state;
+        if (t % 7 == 0) state = STATE_MENU;
+        else if (t % 7 == 1) state = STATE_HIGHSCORE;
+        before = allocCount.load(memory_order_relaxed);
+        drawFrame();
+        frameArenaReset();
+        n = allocCount.load(memory_order_relaxed) - before;
+        state = playing;
+        if (t >= WARMUP_TICKS) { frameTotal += n; worstFrame = max(worstFrame, n); }
+    }
+    printf("alloc-check: %d ticks, %zu allocations (worst tick %zu); %d frames, %zu allocations (worst frame %zu)\n",
+           CHECK_TICKS, tickTotal, worstTick, CHECK_TICKS, frameTotal, worstFrame);
+    return tickTotal == 0 && frameTotal == 0 ? 0 : 1;
+}
+
+#endif // DXBALL_TRACK_ALLOCS
+
+// --- Ball collision benchmark: sweep-and-prune vs all-pairs, 10 to 10k balls ---
+void collideBallsAllPairs() {
+    int n = (int)balls.size();
+    for (int i = 0; i < n; ++i)
+        for (int j = i + 1; j < n; ++j)
+            if (!balls[i].stuck && !balls[j].stuck) resolveBallPair(balls[i], balls[j]);
+}
+
+int runBallBench() {
+    headless = true;
+    rngState = 1234;
+    reserveGameBuffers();
+    recomputeLayout();
+    const int counts[] = { 10, 100, 1000, 10000 };
+    const int TICKS = 200;
+    printf("%8s %14s %14s\n", "balls", "sap us/tick", "naive us/tick");
+    for (int n : counts) {
+        float us[2];
+        for (int mode = 0; mode < 2; ++mode) {
+            rngState = 1234;
+            balls.clear(); sapOrder.clear();
+            for (int i = 0; i < n; ++i) {
+                Ball b;
+                b.r = 2.0f; b.stuck = false; b.mega = (i % 50 == 0); b.gravitySlow = false;
+                if (b.mega) b.r *= 1.9f;
+                b.x = b.r + (gameRand() % 10000) / 10000.0f * (windowWidth - 2*b.r);
+                b.y = b.r + (gameRand() % 10000) / 10000.0f * (windowHeight - 2*b.r);
+                b.sx = ((gameRand() % 200) - 100) / 400.0f;
+                b.sy = ((gameRand() % 200) - 100) / 400.0f;
+                balls.push_back(b);
+            }
+            // naive all-pairs is too slow to run long at 10k
+            int ticks = (mode == 1 && n >= 10000) ? 5 : TICKS;
+            Clock::time_point t0 = Clock::now();
+            for (int t = 0; t < ticks; ++t) {
+                for (auto &b: balls) {
+                    b.x += b.sx; b.y += b.sy;
+                    if (b.x - b.r < 0.0f || b.x + b.r > windowWidth) b.sx = -b.sx;
+                    if (b.y - b.r < 0.0f || b.y + b.r > windowHeight) b.sy = -b.sy;
+                }
+                if (mode == 0) collideBalls(); else collideBallsAllPairs();
+            }
+            us[mode] = chrono::duration<float, micro>(Clock::now() - t0).count() / ticks;
+        }
+        printf("%8d %14.1f %14.1f\n", n, us[0], us[1]);
+    }
+    balls.clear(); sapOrder.clear();
+    return 0;
+}
+
+// --- Game instances: a saved copy of all per-game globals, swapped in around each tick ---
+struct GameInstance {
+    Brick bricks[BR_ROWS * BR_COLS]; int bricks_alive;
+    vector<Ball> balls; vector<Pickup> pickups; vector<Laser> lasers; vector<int> sapOrder;
+    float paddleW, paddleH, paddleX, paddleY;
+    int score, lives, highScore, currentLevel; bool gameStarted; GameState state;
+    bool eggActive; EggType activeEgg; Clock::time_point eggEnd; float speedMultiplier, savedPaddleW;
+    bool laserEnabled, grabActive;
+    unsigned int rngState; Clock::time_point simNow;
+    // env bookkeeping (not swapped)
+    int steps, prevScore, prevLives;
+};
+
+// swapping twice restores both sides, so the same call loads and saves an instance
+void swapGameInstance(GameInstance &g) {
+    swap_ranges(bricks, bricks + BR_ROWS * BR_COLS, g.bricks); swap(bricks_alive, g.bricks_alive);
+    balls.swap(g.balls); pickups.swap(g.pickups); lasers.swap(g.lasers); sapOrder.swap(g.sapOrder);
+    swap(paddleW, g.paddleW); swap(paddleH, g.paddleH); swap(paddleX, g.paddleX); swap(paddleY, g.paddleY);
+    swap(score, g.score); swap(lives, g.lives); swap(highScore, g.highScore); swap(currentLevel, g.currentLevel);
+    swap(gameStarted, g.gameStarted); swap(state, g.state);
+    swap(eggActive, g.eggActive); swap(activeEgg, g.activeEgg); swap(eggEnd, g.eggEnd);
+    swap(speedMultiplier, g.speedMultiplier); swap(savedPaddleW, g.savedPaddleW);
+    swap(laserEnabled, g.laserEnabled); swap(grabActive, g.grabActive);
+    swap(rngState, g.rngState); swap(simNow, g.simNow);
+}
+
+// --- RL environment API (see dxball_env.h) ---
+const int ENV_OBS_BALLS = 8;
+const int ENV_OBS_PICKUPS = 4;
+const int ENV_OBS_SIZE = 3 + ENV_OBS_BALLS * 5 + BR_ROWS * BR_COLS + ENV_OBS_PICKUPS * 4;
+const int ENV_BALL_RESERVE = 64; // per instance; MAX_BALLS per game would be too much memory
+
+struct DxEnv { vector<GameInstance> games; int maxSteps; };
+
+// every DxEnv steps on the same process-wide globals, so calls from different threads take turns
+mutex envMutex;
+
+// operates on the currently swapped-in game
+void envResetGame(GameInstance &g) {
+    paddleX = -1.0f;
+    startNewGame();
+    lasers.clear();
+    grabActive = false;
+    savedPaddleW = paddleW;
+    g.steps = 0; g.prevScore = score; g.prevLives = lives;
+}
+
+void envApplyAction(int action) {
+    float step = windowWidth * 0.02f;
+    if (action == 1) paddleX = clampf(paddleX - step, 0.0f, (float)windowWidth - paddleW);
+    else if (action == 2) paddleX = clampf(paddleX + step, 0.0f, (float)windowWidth - paddleW);
+    else if (action == 3) {
+        bool anyStuck = false;
+        for (auto &b: balls) if (b.stuck) { b.stuck = false; b.sy = -fabs(b.sy); anyStuck = true; }
+        if (!anyStuck && laserEnabled && (int)lasers.size() < MAX_LASERS) {
+            Laser L; L.x = paddleX + paddleW*0.5f; L.y = paddleY; L.h = 6.0f; lasers.push_back(L);
+        }
+    }
+}
+
+void envWriteObservation(float *o) {
+    float iw = 1.0f / windowWidth, ih = 1.0f / windowHeight;
+    *o++ = paddleX * iw; *o++ = paddleY * ih; *o++ = paddleW * iw;
+    int nb = min((int)balls.size(), ENV_OBS_BALLS);
+    for (int i = 0; i < ENV_OBS_BALLS; ++i) {
+        if (i < nb) { *o++ = balls[i].x * iw; *o++ = balls[i].y * ih; *o++ = balls[i].sx; *o++ = balls[i].sy; *o++ = 1.0f; }
+        else { *o++ = 0; *o++ = 0; *o++ = 0; *o++ = 0; *o++ = 0; }
+    }
+    for (int i = 0; i < BR_ROWS * BR_COLS; ++i)
+        *o++ = !bricks[i].alive ? 0.0f : (bricks[i].unbreakable ? 2.0f : 1.0f);
+    int np = 0;
+    for (auto &p: pickups) {
+        if (np == ENV_OBS_PICKUPS) break;
+        if (!p.active) continue;
+        *o++ = p.x * iw; *o++ = p.y * ih; *o++ = p.type / 13.0f; *o++ = 1.0f;
+        np++;
+    }
+    for (; np < ENV_OBS_PICKUPS; ++np) { *o++ = 0; *o++ = 0; *o++ = 0; *o++ = 0; }
+}
+
+extern "C" {
+
+DxEnv *dxenv_create(int num_envs, uint32_t seed, int max_steps) {
+    if (num_envs <= 0) return nullptr;
+    lock_guard<mutex> lk(envMutex);
+    headless = true;
+    DxEnv *env = new DxEnv();
+    env->maxSteps = max_steps;
+    env->games.resize(num_envs);
+    for (int i = 0; i < num_envs; ++i) {
+        GameInstance &g = env->games[i];
+        g.balls.reserve(ENV_BALL_RESERVE); g.pickups.reserve(MAX_PICKUPS);
+        g.lasers.reserve(MAX_LASERS); g.sapOrder.reserve(ENV_BALL_RESERVE);
+        swapGameInstance(g);
+        rngState = seed * 2654435761u + (unsigned int)i * 40503u + 1u;
+        simNow = Clock::time_point();
+        envResetGame(g);
+        swapGameInstance(g);
+    }
+    return env;
+}
+
+void dxenv_destroy(DxEnv *env) { delete env; }
+
+int dxenv_num_envs(const DxEnv *env) { return env ? (int)env->games.size() : 0; }
+
+int dxenv_obs_size(void) { return ENV_OBS_SIZE; }
+
+void dxenv_reset(DxEnv *env, float *obs) {
+    lock_guard<mutex> lk(envMutex);
+    for (size_t i = 0; i < env->games.size(); ++i) {
+        GameInstance &g = env->games[i];
+        swapGameInstance(g);
+        envResetGame(g);
+        envWriteObservation(obs + i * ENV_OBS_SIZE);
+        swapGameInstance(g);
+    }
+}
+
+void dxenv_step(DxEnv *env, const int32_t *actions, float *obs, float *rewards, uint8_t *dones, uint8_t *truncated) {
+    lock_guard<mutex> lk(envMutex);
+    for (size_t i = 0; i < env->games.size(); ++i) {
+        GameInstance &g = env->games[i];
+        swapGameInstance(g);
+        envApplyAction(actions[i]);
+        stepGame();
+        g.steps++;
+        rewards[i] = (score - g.prevScore) / 10.0f - (lives < g.prevLives ? 1.0f : 0.0f);
+        g.prevScore = score; g.prevLives = lives;
+        // game over is terminal; hitting max_steps mid-game is only a truncation
+        bool over = state != STATE_PLAYING;
+        bool cut = !over && env->maxSteps > 0 && g.steps >= env->maxSteps;
+        dones[i] = over ? 1 : 0;
+        truncated[i] = cut ? 1 : 0;
+        if (over || cut) envResetGame(g);
+        envWriteObservation(obs + i * ENV_OBS_SIZE);
+        swapGameInstance(g);
+    }
+}
+
+} // extern "C"
+
+#ifndef DXBALL_NO_MAIN
+// --- Threaded ball update: same seed must give the same game for every thread count ---
+// Uses the game's own split threshold, so the table shows what a real tick gets per ball count;
+// also fails if a timed tick allocates or the checksums differ between thread counts.
+int runThreadBench() {
+    headless = true;
+    reserveGameBuffers();
+    // at least 4 so the determinism check means something on small machines
+    int maxThreads = min(MAX_BALL_THREADS, max(4, (int)thread::hardware_concurrency()));
+    const int ballCounts[] = { 1000, 4000, 12000 };
+    const int TICKS = 300;
+    bool ok = true;
+    printf("%8s %8s %12s %10s %18s\n", "balls", "threads", "ms/tick", "speedup", "checksum");
+    for (int numBalls : ballCounts) {
+        unsigned long long reference = 0;
+        float baseMs = 0.0f;
+        for (int threads = 1; threads <= maxThreads; threads *= 2) {
+            ballThreads = threads;
+            startBallPool();
+            rngState = 1234; simNow = Clock::time_point();
+            recomputeLayout();
+            startNewGame();
+            lives = 1000000;
+            for (int i = 0; i < BR_ROWS * BR_COLS; ++i) bricks[i].unbreakable = (i % 3 != 0);
+            balls.clear();
+            for (int i = 0; i < numBalls; ++i) {
+                spawnBall(windowWidth * (0.05f + 0.9f * (gameRand() % 1000) / 1000.0f), windowHeight * (0.4f + 0.4f * (gameRand() % 1000) / 1000.0f),
+                          (gameRand() & 1) ? 1.0f : -1.0f);
+                balls.back().stuck = false;
+            }
+            size_t allocsBefore = allocCount.load(memory_order_relaxed);
+            Clock::time_point t0 = Clock::now();
+            for (int t = 0; t < TICKS; ++t) {
+                // full-width paddle keeps the field full of balls
+                paddleW = (float)windowWidth; paddleX = 0.0f;
+                stepGame();
+            }
+            float ms = chrono::duration<float, milli>(Clock::now() - t0).count() / TICKS;
+            size_t allocs = allocCount.load(memory_order_relaxed) - allocsBefore;
+            unsigned long long sum = (unsigned long long)score * 1000003ull + (unsigned long long)bricks_alive * 7919ull + rngState + balls.size();
+            for (auto &b: balls) { unsigned int bits; memcpy(&bits, &b.x, 4); sum = sum * 31 + bits; memcpy(&bits, &b.y, 4); sum = sum * 31 + bits; }
+            if (threads == 1) { reference = sum; baseMs = ms; }
+            else if (sum != reference) ok = false;
+            if (allocs) { printf("thread-bench: %zu allocations in timed ticks\n", allocs); ok = false; }
+            printf("%8d %8d %12.3f %9.2fx %18llx\n", numBalls, threads, ms, baseMs / ms, sum);
+        }
+    }
+    printf(ok ? "thread-bench: deterministic, no allocations\n" : "thread-bench: FAILED\n");
+    return ok ? 0 : 1;
+}
+
+// --- Env throughput benchmark: random actions through the batched API ---
+int runEnvBench() {
+    const int NUM_ENVS = 256, STEPS = 4000;
+    DxEnv *env = dxenv_create(NUM_ENVS, 1234, 5000);
+    vector<float> obs((size_t)NUM_ENVS * ENV_OBS_SIZE), rewards(NUM_ENVS);
+    vector<int32_t> actions(NUM_ENVS);
+    vector<uint8_t> dones(NUM_ENVS), truncated(NUM_ENVS);
+    dxenv_reset(env, obs.data());
+    long episodes = 0;
+    Clock::time_point t0 = Clock::now();
+    for (int t = 0; t < STEPS; ++t) {
+        for (int i = 0; i < NUM_ENVS; ++i) actions[i] = gameRand() & 3;
+        dxenv_step(env, actions.data(), obs.data(), rewards.data(), dones.data(), truncated.data());
+        for (int i = 0; i < NUM_ENVS; ++i) episodes += dones[i] + truncated[i];
+    }
+    float sec = chrono::duration<float>(Clock::now() - t0).count();
+    printf("env-bench: %d envs x %d steps in %.2fs = %.2fM steps/s (%ld episodes)\n",
+           NUM_ENVS, STEPS, sec, NUM_ENVS * (double)STEPS / sec / 1e6, episodes);
+    dxenv_destroy(env);
+    return 0;
+}
+
 // --- Main ---
 int main(int argc, char** argv) {
-    srand((unsigned int)time(NULL));
+    if (argc > 1 && strcmp(argv[1], "--alloc-check") == 0) return runAllocCheck();
+    if (argc > 1 && strcmp(argv[1], "--bench-balls") == 0) return runBallBench();
+    if (argc > 1 && strcmp(argv[1], "--bench-env") == 0) return runEnvBench();
+    if (argc > 1 && strcmp(argv[1], "--bench-threads") == 0) return runThreadBench();
+    ballThreads = max(1, min(8, (int)thread::hardware_concurrency()));
+    rngState = (unsigned int)time(NULL);
     glutInit(&argc, argv);
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGBA);
     glutInitWindowSize(windowWidth, windowHeight);
@@ -783,3 +1750,4 @@ int main(int argc, char** argv) {
     glutMainLoop();
     return 0;
 }
+#endif // DXBALL_NO_MAIN
@@ -0,0 +1,50 @@
+// dxball_env.h - C ABI for running many headless DX Ball games in one batched call.
+//
+// Build as a shared library (no window, no main):
+//   g++ -O2 -pthread -shared -fPIC -DDXBALL_NO_MAIN 151_164.cpp -o libdxball.so -lglut -lGLU -lGL
+// The library leaves the host's global operator new/delete alone; add -DDXBALL_TRACK_ALLOCS
+// only if the host wants the game's allocation counters.
+//
+// All buffers are caller-owned and contiguous, laid out env-major:
+//   obs     float   [num_envs * dxenv_obs_size()]
+//   actions int32_t [num_envs]   0 = stay, 1 = left, 2 = right, 3 = launch/fire
+//   rewards   float   [num_envs] score gained / 10, minus 1 per life lost. Score is 10 per brick,
+//                                 plus the +50 level-clear and +100 score-pickup bonuses
+//   dones     uint8_t [num_envs] 1 when the game ended (last life lost): a true terminal state
+//   truncated uint8_t [num_envs] 1 when max_steps ran out mid-game: bootstrap from the value here
+// At most one of dones/truncated is set. Either way the game is reset inside dxenv_step,
+// and its obs row then holds the first observation of the new episode.
+//
+// Threading: all DxEnv handles share process-wide game state, which is swapped in around
+// each tick. Entry points are serialised by one process-wide lock, so calls from several
+// threads are safe but never run in parallel; use separate processes to scale out.
+//
+// Observation row (all floats, positions normalised to the 800x600 playfield):
+//   [0..2]    paddle x, y, width
+//   [3..42]   8 balls  x (x, y, sx, sy, present)
+//   [43..92]  5x10 bricks, row-major: 0 = gone, 1 = breakable, 2 = unbreakable
+//   [93..108] 4 pickups x (x, y, type/13, present)
+#ifndef DXBALL_ENV_H
+#define DXBALL_ENV_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct DxEnv DxEnv;
+
+// max_steps <= 0 means episodes only end when the last life is lost
+DxEnv *dxenv_create(int num_envs, uint32_t seed, int max_steps);
+void dxenv_destroy(DxEnv *env);
+int dxenv_num_envs(const DxEnv *env);
+int dxenv_obs_size(void);
+void dxenv_reset(DxEnv *env, float *obs);
+void dxenv_step(DxEnv *env, const int32_t *actions, float *obs, float *rewards, uint8_t *dones, uint8_t *truncated);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,92 @@
+"""Thin ctypes wrapper over libdxball.so (see dxball_env.h).
+
+Buffers are allocated once here and handed to the library on every step, so
+observations, rewards and dones are written in place. If numpy is installed
+they are exposed as numpy views over the same memory (no copies).
+"""
+import ctypes
+import os
+
+try:
+    import numpy as np
+except ImportError:
+    np = None
+
+
+class DxBallVecEnv:
+    def __init__(self, num_envs, seed=0, max_steps=0, lib_path=None):
+        path = lib_path or os.path.join(os.path.dirname(os.path.abspath(__file__)), "libdxball.so")
+        self._lib = lib = ctypes.CDLL(path)
+        lib.dxenv_create.restype = ctypes.c_void_p
+        lib.dxenv_create.argtypes = [ctypes.c_int, ctypes.c_uint32, ctypes.c_int]
+        lib.dxenv_destroy.argtypes = [ctypes.c_void_p]
+        lib.dxenv_obs_size.restype = ctypes.c_int
+        lib.dxenv_reset.argtypes = [ctypes.c_void_p, ctypes.c_void_p]
+        lib.dxenv_step.argtypes = [ctypes.c_void_p] * 6
+
+        self.num_envs = num_envs
+        self.obs_size = lib.dxenv_obs_size()
+        self._env = lib.dxenv_create(num_envs, seed, max_steps)
+        if not self._env:
+            raise ValueError("dxenv_create failed")
+
+        self._obs = (ctypes.c_float * (num_envs * self.obs_size))()
+        self._rewards = (ctypes.c_float * num_envs)()
+        self._dones = (ctypes.c_uint8 * num_envs)()
+        self._truncated = (ctypes.c_uint8 * num_envs)()
+        self._actions = (ctypes.c_int32 * num_envs)()
+
+        if np is not None:
+            self.obs = np.frombuffer(self._obs, dtype=np.float32).reshape(num_envs, self.obs_size)
+            self.rewards = np.frombuffer(self._rewards, dtype=np.float32)
+            self.dones = np.frombuffer(self._dones, dtype=np.uint8)
+            self.truncated = np.frombuffer(self._truncated, dtype=np.uint8)
+            self.actions = np.frombuffer(self._actions, dtype=np.int32)
+        else:
+            self.obs = memoryview(self._obs).cast("B").cast("f")
+            self.rewards = memoryview(self._rewards).cast("B").cast("f")
+            self.dones = memoryview(self._dones).cast("B")
+            self.truncated = memoryview(self._truncated).cast("B")
+            self.actions = memoryview(self._actions).cast("B").cast("i")
+
+    def reset(self):
+        self._lib.dxenv_reset(self._env, self._obs)
+        return self.obs
+
+    def step(self, actions=None):
+        """Step every game once. Pass actions, or fill self.actions in place and pass None.
+
+        Returns (obs, rewards, dones, truncated): dones marks game over, truncated marks max_steps.
+        """
+        if actions is not None:
+            if np is not None:
+                self.actions[:] = actions
+            else:
+                for i, a in enumerate(actions):
+                    self.actions[i] = a
+        self._lib.dxenv_step(self._env, self._actions, self._obs, self._rewards, self._dones, self._truncated)
+        return self.obs, self.rewards, self.dones, self.truncated
+
+    def close(self):
+        if self._env:
+            self._lib.dxenv_destroy(self._env)
+            self._env = None
+
+    def __del__(self):
+        self.close()
+
+
+if __name__ == "__main__":
+    import random
+    import time
+
+    env = DxBallVecEnv(256, seed=1, max_steps=5000)
+    env.reset()
+    steps = 2000
+    t0 = time.perf_counter()
+    for _ in range(steps):
+        for i in range(env.num_envs):
+            env.actions[i] = random.randrange(4)
+        env.step()
+    dt = time.perf_counter() - t0
+    print(f"{env.num_envs * steps / dt / 1e6:.2f}M env-steps/s (including Python action loop)")